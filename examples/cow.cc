@@ -0,0 +1,72 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include "xcmixin/cow.hpp"
+
+class Snapshot;
+XCMIXIN_IMPL_AVAILABLE(Snapshot);
+
+struct table {
+    std::vector<double> values = std::vector<double>(1 << 14, 1.0);
+};
+
+// the table is shared by copies of Snapshot until one of them writes it
+XCMIXIN_DEF_COW_BEGIN(table_method, table)
+double lookup(std::size_t i) const { return xcmixin_state.values[i]; }
+void store(std::size_t i, double v) { xcmixin_state.values[i] = v; }
+bool shares_table() const { return !xcmixin_cow_state.unique(); }
+XCMIXIN_DEF_END()
+
+XCMIXIN_DEF_BEGIN(version_method)
+int version = 0;
+XCMIXIN_DEF_END()
+
+using recorder = xcmixin::mixin_recorder<table_method, version_method>;
+
+class Snapshot : public xcmixin::impl_recorder<Snapshot, recorder> {
+    xcmixin_init_class;
+};
+
+// the same payload held directly, copied deeply
+struct DeepSnapshot {
+    table state;
+};
+
+template <typename F>
+double measure(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+int main() {
+    Snapshot origin;
+    std::vector<Snapshot> snapshots;
+    snapshots.reserve(1000);
+    double cow_ms = measure([&] {
+        for (int i = 0; i < 1000; ++i) snapshots.push_back(origin);
+    });
+
+    DeepSnapshot deep_origin;
+    std::vector<DeepSnapshot> deep_snapshots;
+    deep_snapshots.reserve(1000);
+    double deep_ms = measure([&] {
+        for (int i = 0; i < 1000; ++i) deep_snapshots.push_back(deep_origin);
+    });
+
+    // the first write detaches only the written snapshot
+    snapshots[1].store(0, 2.0);
+    bool ok = snapshots[0].shares_table() && !snapshots[1].shares_table() &&
+              origin.lookup(0) == 1.0 && snapshots[1].lookup(0) == 2.0;
+
+    std::cout << "copy on write: " << cow_ms << " ms for 1000 copies"
+              << std::endl;
+    std::cout << "deep copy:     " << deep_ms << " ms for 1000 copies"
+              << std::endl;
+    std::cout << "results " << (ok ? "match" : "differ") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "xcmixin/expr.hpp"
+
+class Vec;
+XCMIXIN_IMPL_AVAILABLE(Vec);
+
+// replace the generic fused loop of Vec for a + b with a hand written kernel
+XCMIXIN_IMPL_BEGIN(xcmixin::expr::expr_eval)
+XCMIXIN_IMPL_FOR(Vec)
+template <typename E>
+void eval(const E& e) {
+    xcmixin::expr::fused_eval(xcmixin_self, e);
+}
+void eval(const xcmixin::expr::add_t<Vec, Vec>& e);
+XCMIXIN_IMPL_END()
+
+using recorder = xcmixin::mixin_recorder<
+    xcmixin::expr::expr_assign, xcmixin::expr::expr_eval,
+    xcmixin::expr::expr_add, xcmixin::expr::expr_mul, xcmixin::expr::expr_dot>;
+
+class Vec : public xcmixin::impl_recorder<Vec, recorder> {
+    xcmixin_init_class;
+
+   public:
+    template <xcmixin::expr::node E>
+    Vec& operator=(const E& e) {
+        return assign(e);
+    }
+    explicit Vec(std::size_t n = 0, double v = 0) : data(n, v) {}
+    std::size_t size() const { return data.size(); }
+    void resize(std::size_t n) { data.resize(n); }
+    double& operator[](std::size_t i) { return data[i]; }
+    double operator[](std::size_t i) const { return data[i]; }
+
+    std::vector<double> data;
+};
+
+template <typename Base, typename meta>
+void xcmixin::expr::expr_eval<Base, Vec, meta>::eval(
+    const xcmixin::expr::add_t<Vec, Vec>& e) {
+    const double* a = e.l.data.data();
+    const double* b = e.r.data.data();
+    xcmixin_self.resize(e.size());
+    double* out = xcmixin_self.data.data();
+    std::size_t n = e.size(), i = 0;
+#ifdef __SSE2__
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(out + i,
+                      _mm_add_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+#endif
+    for (; i < n; ++i) out[i] = a[i] + b[i];
+}
+
+// the same arithmetic evaluated eagerly, one temporary per operation
+struct EagerVec {
+    std::vector<double> data;
+};
+EagerVec operator+(const EagerVec& l, const EagerVec& r) {
+    EagerVec out{std::vector<double>(l.data.size())};
+    for (std::size_t i = 0; i < l.data.size(); ++i)
+        out.data[i] = l.data[i] + r.data[i];
+    return out;
+}
+EagerVec operator*(const EagerVec& l, const EagerVec& r) {
+    EagerVec out{std::vector<double>(l.data.size())};
+    for (std::size_t i = 0; i < l.data.size(); ++i)
+        out.data[i] = l.data[i] * r.data[i];
+    return out;
+}
+EagerVec operator*(const EagerVec& l, double r) {
+    EagerVec out{std::vector<double>(l.data.size())};
+    for (std::size_t i = 0; i < l.data.size(); ++i)
+        out.data[i] = l.data[i] * r;
+    return out;
+}
+
+template <typename F>
+double measure(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10; ++i) f();
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+               .count() /
+           10;
+}
+
+int main() {
+    const std::size_t n = 1 << 22;
+    Vec a(n), b(n), c(n), d(n), r;
+    EagerVec ea{std::vector<double>(n)}, eb = ea, ec = ea, ed = ea, er;
+    for (std::size_t i = 0; i < n; ++i) {
+        ea.data[i] = a[i] = static_cast<double>(i % 7);
+        eb.data[i] = b[i] = static_cast<double>(i % 11);
+        ec.data[i] = c[i] = static_cast<double>(i % 13);
+        ed.data[i] = d[i] = static_cast<double>(i % 17);
+    }
+
+    double fused_ms = measure([&] { r = a + b * c + d * 0.5; });
+    double eager_ms = measure([&] { er = ea + eb * ec + ed * 0.5; });
+    bool same = r.size() == n && er.data.size() == n;
+    for (std::size_t i = 0; same && i < n; ++i)
+        same = r[i] == a[i] + b[i] * c[i] + d[i] * 0.5 && er.data[i] == r[i];
+
+    double kernel_ms = measure([&] { r.assign(a + b); });
+    for (std::size_t i = 0; same && i < n; ++i) same = r[i] == a[i] + b[i];
+
+    // small integers, both sums are exact
+    double dot = xcmixin::expr::dot(a + b, c);
+    same = same && dot == a.dot(c) + b.dot(c);
+    std::cout << "fused:  " << fused_ms << " ms" << std::endl;
+    std::cout << "eager:  " << eager_ms << " ms" << std::endl;
+    std::cout << "kernel: " << kernel_ms << " ms (a + b)" << std::endl;
+    std::cout << "dot:    " << dot << " == " << a.dot(c) + b.dot(c)
+              << std::endl;
+    std::cout << "results " << (same ? "match" : "differ") << std::endl;
+    return same ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "xcmixin/fieldwise.hpp"
+
+class Cell;
+XCMIXIN_IMPL_AVAILABLE(Cell);
+class Entry;
+XCMIXIN_IMPL_AVAILABLE(Entry);
+
+// every layer declares its own fields, compare and xcmixin::hash collect them
+XCMIXIN_DEF_BEGIN(position_method)
+int x = 0, y = 0, z = 0;
+xcmixin_fields(x, y, z)
+XCMIXIN_DEF_END()
+
+XCMIXIN_DEF_BEGIN(layer_method)
+int layer = 0;
+xcmixin_fields(layer)
+XCMIXIN_DEF_END()
+
+XCMIXIN_DEF_BEGIN(name_method)
+std::string name;
+xcmixin_fields(name)
+XCMIXIN_DEF_END()
+
+XCMIXIN_DEF_BEGIN(id_method)
+long id = 0;
+xcmixin_fields(id)
+XCMIXIN_DEF_END()
+
+// ints without padding, == is a memcmp and the hash reads whole words
+class Cell
+    : public xcmixin::impl_recorder<
+          Cell, xcmixin::mixin_recorder<xcmixin::fieldwise::compare,
+                                        position_method, layer_method>> {
+    xcmixin_init_class;
+};
+static_assert(xcmixin::is_bitwise_comparable<Cell>);
+
+// a string field, compared and hashed field by field
+class Entry
+    : public xcmixin::impl_recorder<
+          Entry, xcmixin::mixin_recorder<xcmixin::fieldwise::compare,
+                                         name_method, id_method>> {
+    xcmixin_init_class;
+};
+static_assert(!xcmixin::is_bitwise_comparable<Entry>);
+
+// the same classes written by hand
+struct HandCell {
+    int x = 0, y = 0, z = 0, layer = 0;
+    bool operator==(const HandCell&) const = default;
+};
+struct HandCellHash {
+    std::size_t operator()(const HandCell& c) const {
+        std::size_t h = std::hash<int>{}(c.x);
+        for (int v : {c.y, c.z, c.layer})
+            h ^= std::hash<int>{}(v) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+struct HandEntry {
+    std::string name;
+    long id = 0;
+    bool operator==(const HandEntry&) const = default;
+};
+struct HandEntryHash {
+    std::size_t operator()(const HandEntry& e) const {
+        std::size_t h = std::hash<std::string>{}(e.name);
+        return h ^ (std::hash<long>{}(e.id) + 0x9e3779b9 + (h << 6) + (h >> 2));
+    }
+};
+
+template <typename F>
+double measure(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// insert every item twice, the set keeps one copy of each
+template <typename T, typename Hash>
+std::size_t insert_twice(const std::vector<T>& items, double& ms) {
+    std::unordered_set<T, Hash> set;
+    ms = measure([&] {
+        for (int round = 0; round < 2; ++round)
+            for (const T& item : items) set.insert(item);
+    });
+    return set.size();
+}
+
+int main() {
+    constexpr int n = 1 << 18;
+    std::vector<Cell> cells(n);
+    std::vector<HandCell> hand_cells(n);
+    std::vector<Entry> entries(n);
+    std::vector<HandEntry> hand_entries(n);
+    for (int i = 0; i < n; ++i) {
+        cells[i].x = i % 64;
+        cells[i].y = i / 64 % 64;
+        cells[i].z = i / 4096;
+        cells[i].layer = i % 3;
+        hand_cells[i] = {cells[i].x, cells[i].y, cells[i].z, cells[i].layer};
+        entries[i].name = "entry-" + std::to_string(i % (n / 2));
+        entries[i].id = i % 7;
+        hand_entries[i] = {entries[i].name, entries[i].id};
+    }
+
+    double cell_ms, hand_cell_ms, entry_ms, hand_entry_ms;
+    std::size_t cell_count =
+        insert_twice<Cell, xcmixin::hash<Cell>>(cells, cell_ms);
+    std::size_t hand_cell_count =
+        insert_twice<HandCell, HandCellHash>(hand_cells, hand_cell_ms);
+    std::size_t entry_count =
+        insert_twice<Entry, xcmixin::hash<Entry>>(entries, entry_ms);
+    std::size_t hand_entry_count =
+        insert_twice<HandEntry, HandEntryHash>(hand_entries, hand_entry_ms);
+
+    // fields are ordered layer by layer, in recorder order
+    Entry a, b;
+    a.name = b.name = "same";
+    a.id = 1;
+    b.id = 2;
+    bool ok = cell_count == hand_cell_count &&
+              entry_count == hand_entry_count && a < b && a != b &&
+              cells[1] != cells[2] && cells[1] == Cell(cells[1]);
+
+    std::cout << "generated cell set:    " << cell_ms << " ms" << std::endl;
+    std::cout << "hand-written cell set: " << hand_cell_ms << " ms"
+              << std::endl;
+    std::cout << "generated entry set:    " << entry_ms << " ms" << std::endl;
+    std::cout << "hand-written entry set: " << hand_entry_ms << " ms"
+              << std::endl;
+    std::cout << "results " << (ok ? "match" : "differ") << std::endl;
+    return ok ? 0 : 1;
+}
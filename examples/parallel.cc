@@ -0,0 +1,91 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "xcmixin/parallel.hpp"
+
+class Particle;
+XCMIXIN_IMPL_AVAILABLE(Particle);
+XCMIXIN_PRE_DECL(position_method)
+XCMIXIN_PRE_DECL(step_method)
+XCMIXIN_PRE_DECL(log_method)
+// position_method only reads, step_method writes its own object
+XCMIXIN_CONCURRENCY(position_method, read_only_)
+XCMIXIN_CONCURRENCY(step_method, per_object_)
+// log_method writes to std::cout and is left undeclared: not parallel safe
+
+XCMIXIN_DEF_BEGIN(position_method)
+double position() const { return xcmixin_const_self.x; }
+XCMIXIN_DEF_END()
+
+XCMIXIN_DEF_BEGIN(step_method)
+void step(double dt) {
+    for (int i = 0; i < 64; ++i) {
+        xcmixin_self.v -= std::sin(xcmixin_self.x) * dt;
+        xcmixin_self.x += xcmixin_self.v * dt;
+    }
+}
+XCMIXIN_DEF_END()
+
+XCMIXIN_DEF_BEGIN(log_method)
+void log() const { std::cout << xcmixin_const_self.position() << std::endl; }
+XCMIXIN_DEF_END()
+
+using recorder = xcmixin::mixin_recorder<position_method, step_method>;
+
+class Particle : public xcmixin::impl_recorder<Particle, recorder> {
+    xcmixin_init_class;
+
+   public:
+    double x = 0;
+    double v = 1;
+};
+
+class LoggedParticle;
+using logged_recorder = recorder::push_back<log_method>;
+class LoggedParticle
+    : public xcmixin::impl_recorder<LoggedParticle, logged_recorder> {
+    xcmixin_init_class;
+
+   public:
+    double x = 0;
+    double v = 1;
+};
+
+static_assert(xcmixin::is_parallel_safe<Particle>);
+static_assert(!xcmixin::is_parallel_safe<LoggedParticle>);
+
+template <typename F>
+double measure(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+int main() {
+    std::vector<Particle> serial(1 << 20), parallel(1 << 20);
+    for (std::size_t i = 0; i < serial.size(); ++i)
+        serial[i].x = parallel[i].x = static_cast<double>(i % 1000) / 1000;
+
+    double serial_ms = measure([&] {
+        for (auto& p : serial) p.step(0.01);
+    });
+    double parallel_ms = measure([&] {
+        xcmixin::parallel_for_each<&Particle::step>(parallel, 0.01);
+    });
+    // xcmixin::parallel_for_each<&LoggedParticle::log>(logged);  // error:
+    // log_method is not parallel safe
+
+    bool same = true;
+    for (std::size_t i = 0; i < serial.size(); ++i)
+        same = same && serial[i].position() == parallel[i].position();
+    std::cout << "threads:  " << xcmixin::thread_pool::instance().concurrency()
+              << std::endl;
+    std::cout << "serial:   " << serial_ms << " ms" << std::endl;
+    std::cout << "parallel: " << parallel_ms << " ms" << std::endl;
+    std::cout << "results " << (same ? "match" : "differ") << std::endl;
+    return same ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+#include <iostream>
+#include <string>
+
+#include "xcmixin/state_machine.hpp"
+
+class Connection;
+XCMIXIN_IMPL_AVAILABLE(Connection);
+
+struct connect_event {};
+struct ack_event {};
+struct data_event {
+    std::string payload;
+};
+struct close_event {};
+
+XCMIXIN_PRE_DECL(idle_state)
+XCMIXIN_PRE_DECL(handshake_state)
+XCMIXIN_PRE_DECL(open_state)
+XCMIXIN_PRE_DECL(log_method)
+// transitions are declared statically, leaving a state any other way is a
+// compile error
+XCMIXIN_TRANSITIONS(idle_state, handshake_state)
+XCMIXIN_TRANSITIONS(handshake_state, open_state, idle_state)
+XCMIXIN_TRANSITIONS(open_state, idle_state)
+XCMIXIN_REQUIRE(open_state, xcmixin_require_mixin(log_method);)
+
+XCMIXIN_DEF_BEGIN(log_method)
+void log(const std::string& message) {
+    std::cout << "[" << xcmixin_self.state_index() << "] " << message
+              << std::endl;
+}
+XCMIXIN_DEF_END()
+
+XCMIXIN_DEF_BEGIN(idle_state)
+void on_event(const connect_event&) {
+    xcmixin_transition(handshake_state);
+    // xcmixin_transition(open_state);  // error: transition is not declared
+}
+XCMIXIN_DEF_END()
+
+XCMIXIN_DEF_BEGIN(handshake_state)
+void on_enter() { xcmixin_self.log("handshake"); }
+void on_event(const ack_event&) { xcmixin_transition(open_state); }
+void on_event(const close_event&) { xcmixin_transition(idle_state); }
+XCMIXIN_DEF_END()
+
+XCMIXIN_DEF_BEGIN(open_state)
+void on_enter() { xcmixin_self.log("open"); }
+void on_exit() { xcmixin_self.log("closing"); }
+void on_event(const data_event& e) {
+    ++xcmixin_self.received;
+    xcmixin_self.log("data " + e.payload);
+}
+void on_event(const close_event&) { xcmixin_transition(idle_state); }
+XCMIXIN_DEF_END()
+
+using states =
+    xcmixin::mixin_recorder<idle_state, handshake_state, open_state>;
+using recorder = xcmixin::mixin_recorder<log_method>;
+
+class Connection
+    : public xcmixin::state_machine<Connection, states, recorder> {
+    xcmixin_init_class;
+
+   public:
+    int received = 0;
+};
+
+static_assert(sizeof(Connection) == 2 * sizeof(int));
+static_assert(xcmixin::Impl<Connection, open_state, log_method>);
+
+int main() {
+    Connection connection;
+    connection.dispatch(data_event{"dropped"});  // idle ignores data
+    connection.dispatch(connect_event{});
+    connection.dispatch(ack_event{});
+    connection.dispatch(data_event{"hello"});
+    connection.dispatch(data_event{"world"});
+    bool handled = connection.dispatch(ack_event{});  // open ignores ack
+    connection.dispatch(close_event{});
+
+    std::cout << "received: " << connection.received << std::endl;
+    std::cout << "ack handled when open: " << std::boolalpha << handled
+              << std::endl;
+    return connection.in_state<idle_state>() ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include "xcmixin/strategy.hpp"
+
+// strategies
+XCMIXIN_DEF_BEGIN(square_strategy)
+double apply(double x) const { return x * x; }
+XCMIXIN_DEF_END()
+
+XCMIXIN_DEF_BEGIN(cube_strategy)
+double apply(double x) const { return x * x * x; }
+XCMIXIN_DEF_END()
+
+XCMIXIN_DEF_BEGIN(scale_strategy)
+double apply(double x) const { return x * xcmixin_const_self.factor; }
+XCMIXIN_DEF_END()
+
+XCMIXIN_DEF_BEGIN(sum_method)
+double sum(const std::vector<double>& values) const {
+    double total = 0;
+    for (double v : values) total += xcmixin_const_self.apply(v);
+    return total;
+}
+XCMIXIN_DEF_END()
+
+template <XCMIXIN_MIXIN_TEMPLATE_PARAM strategy>
+using kernel_recorder = xcmixin::mixin_recorder<strategy, sum_method>;
+template <XCMIXIN_MIXIN_TEMPLATE_PARAM strategy>
+class Kernel : public xcmixin::impl_recorder<Kernel<strategy>,
+                                             kernel_recorder<strategy>> {
+    xcmixin_init_template(
+        xcmixin::impl_recorder<Kernel<strategy>, kernel_recorder<strategy>>);
+
+   public:
+    Kernel(double factor = 3) : factor(factor) {}
+    double factor;
+};
+
+using strategies =
+    xcmixin::mixin_recorder<square_strategy, cube_strategy, scale_strategy>;
+using kernel_switch = xcmixin::strategy_switch<Kernel, strategies>;
+static_assert(kernel_switch::index_of<cube_strategy> == 1);
+
+// the same strategies behind virtual calls
+struct VirtualKernel {
+    virtual ~VirtualKernel() = default;
+    virtual double apply(double x) const = 0;
+};
+template <XCMIXIN_MIXIN_TEMPLATE_PARAM strategy>
+struct VirtualAdapter : VirtualKernel {
+    Kernel<strategy> kernel;
+    double apply(double x) const override { return kernel.apply(x); }
+};
+
+template <typename F>
+double measure(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+int main(int argc, char**) {
+    // the strategy is a runtime value, chosen here from the argument count
+    std::size_t index =
+        static_cast<std::size_t>(argc - 1) % kernel_switch::size;
+    std::vector<double> values(1 << 22);
+    for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = std::sin(static_cast<double>(i));
+
+    double results[4] = {};
+    double switch_ms = measure([&] {
+        results[0] = kernel_switch::dispatch(
+            index, [&](const auto& kernel) { return kernel.sum(values); });
+    });
+
+    std::variant<Kernel<square_strategy>, Kernel<cube_strategy>,
+                 Kernel<scale_strategy>>
+        variant;
+    kernel_switch::dispatch(index, [&](auto& kernel) { variant = kernel; });
+    double variant_ms = measure([&] {
+        double total = 0;
+        for (double v : values)
+            total += std::visit([&](auto& k) { return k.apply(v); }, variant);
+        results[1] = total;
+    });
+
+    std::unique_ptr<VirtualKernel> virtual_kernel;
+    kernel_switch::dispatch(index, [&]<typename K>(K&) {
+        if constexpr (std::is_same_v<K, Kernel<square_strategy>>)
+            virtual_kernel =
+                std::make_unique<VirtualAdapter<square_strategy>>();
+        else if constexpr (std::is_same_v<K, Kernel<cube_strategy>>)
+            virtual_kernel = std::make_unique<VirtualAdapter<cube_strategy>>();
+        else
+            virtual_kernel =
+                std::make_unique<VirtualAdapter<scale_strategy>>();
+    });
+    double virtual_ms = measure([&] {
+        double total = 0;
+        for (double v : values) total += virtual_kernel->apply(v);
+        results[2] = total;
+    });
+
+    double per_call_ms = measure([&] {
+        double total = 0;
+        for (double v : values)
+            total += kernel_switch::dispatch(
+                index, [&](const auto& kernel) { return kernel.apply(v); });
+        results[3] = total;
+    });
+
+    std::cout << "strategy index:              " << index << std::endl;
+    std::cout << "strategy_switch (hoisted):   " << switch_ms << " ms"
+              << std::endl;
+    std::cout << "strategy_switch (per call):  " << per_call_ms << " ms"
+              << std::endl;
+    std::cout << "std::variant + std::visit:   " << variant_ms << " ms"
+              << std::endl;
+    std::cout << "virtual call:                " << virtual_ms << " ms"
+              << std::endl;
+    bool same = results[0] == results[1] && results[1] == results[2] &&
+                results[2] == results[3];
+    std::cout << "results " << (same ? "match" : "differ") << std::endl;
+    return same ? 0 : 1;
+}
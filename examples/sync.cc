@@ -0,0 +1,98 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "xcmixin/sync.hpp"
+
+class Stats;
+XCMIXIN_IMPL_AVAILABLE(Stats);
+XCMIXIN_PRE_DECL(counter_method)
+XCMIXIN_PRE_DECL(name_method)
+XCMIXIN_PRE_DECL(min_method)
+XCMIXIN_PRE_DECL(max_method)
+
+struct range_group;
+// trivially copyable, so it can sit behind a seqlock
+struct counter {
+    long count = 0;
+};
+// read mostly counter behind a seqlock, the name behind a reader writer lock
+XCMIXIN_LOCK(counter_method, xcmixin::sync::seq_lock<counter>)
+XCMIXIN_LOCK(name_method, xcmixin::sync::rw_lock)
+// min and max change together and share one lock
+XCMIXIN_LOCK(min_method, xcmixin::sync::mutex_lock, range_group)
+XCMIXIN_LOCK(max_method, xcmixin::sync::mutex_lock, range_group)
+
+// the counter is read and written as a whole through seq_data
+XCMIXIN_DEF_SEQ_BEGIN(counter_method, counter)
+void add(long n) {
+    counter c = xcmixin_seq_state.load();
+    c.count += n;
+    xcmixin_seq_state.store(c);
+}
+long total() const { return xcmixin_seq_state.load().count; }
+XCMIXIN_DEF_END()
+
+XCMIXIN_DEF_BEGIN(name_method)
+void rename(std::string n) { name = std::move(n); }
+std::string current_name() const { return name; }
+std::string name = "stats";
+XCMIXIN_DEF_END()
+
+XCMIXIN_DEF_BEGIN(min_method)
+void update_min(long v) { low = v < low ? v : low; }
+long min() const { return low; }
+long low = 1 << 30;
+XCMIXIN_DEF_END()
+
+XCMIXIN_DEF_BEGIN(max_method)
+void update_max(long v) { high = v > high ? v : high; }
+long max() const { return high; }
+long high = -(1 << 30);
+XCMIXIN_DEF_END()
+
+// guarded must come first, it guards the mixins after it
+using recorder =
+    xcmixin::mixin_recorder<xcmixin::sync::guarded, counter_method,
+                            name_method, min_method, max_method>;
+
+class Stats : public xcmixin::impl_recorder<Stats, recorder> {
+    xcmixin_init_class;
+};
+
+int main() {
+    Stats stats;
+    std::vector<std::thread> threads;
+    for (long t = 0; t < 4; ++t) {
+        threads.emplace_back([&stats, t] {
+            for (long i = 0; i < 10000; ++i) {
+                stats.locked<&Stats::add>(1);
+                long v = t * 10000 + i;
+                // one critical section for two mixins of the same group
+                std::lock_guard guard(stats.lock_of<min_method>());
+                stats.update_min(v);
+                stats.update_max(v);
+            }
+        });
+        threads.emplace_back([&stats] {
+            long last = 0;
+            for (int i = 0; i < 10000; ++i) {
+                long now = stats.locked<&Stats::total>();
+                if (now < last) std::cout << "counter went back" << std::endl;
+                last = now;
+                stats.locked<&Stats::current_name>();
+            }
+        });
+    }
+    stats.locked<&Stats::rename>(std::string("shared stats"));
+    for (auto& thread : threads) thread.join();
+
+    const Stats copy = stats;  // copies share no lock
+    std::cout << copy.locked<&Stats::current_name>() << ": "
+              << copy.locked<&Stats::total>() << " in [" << copy.min() << ", "
+              << copy.max() << "]" << std::endl;
+    return copy.total() == 40000 && copy.min() == 0 && copy.max() == 39999
+               ? 0
+               : 1;
+}
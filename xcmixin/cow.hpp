@@ -0,0 +1,100 @@
+// cow.hpp
+// Copy on write state for mixin layers.
+//
+// Copyright (c) 2024 Tian Li
+// Licensed under the MIT License.
+//
+// https://github.com/X-ChenD-Hai/xcmixin
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "xcmixin.hpp"
+
+namespace xcmixin {
+namespace details {
+// copy on write holder, copies share one refcounted block and the first
+// non-const access to a shared block detaches a private copy. a non-const
+// access also marks the block unshareable, since the reference it returns may
+// outlive it, and copies of an unshareable block copy the value. moves are
+// copies and leave the source usable
+template <typename T>
+class cow {
+   public:
+    cow() : block_(new block()) {}
+    template <typename... Args>
+    explicit cow(std::in_place_t, Args&&... args)
+        : block_(new block(std::forward<Args>(args)...)) {}
+    cow(const cow& other) : block_(other.share()) {}
+    cow& operator=(const cow& other) {
+        block* shared = other.share();
+        release();
+        block_ = shared;
+        return *this;
+    }
+    ~cow() { release(); }
+
+    const T& get() const noexcept { return block_->value; }
+    T& get() {
+        detach();
+        block_->unshareable = true;
+        return block_->value;
+    }
+    const T& operator*() const noexcept { return get(); }
+    T& operator*() { return get(); }
+    const T* operator->() const noexcept { return &get(); }
+    T* operator->() { return &get(); }
+
+    // whether no other copy shares the state
+    bool unique() const noexcept {
+        return block_->refs.load(std::memory_order_acquire) == 1;
+    }
+
+   private:
+    struct block {
+        template <typename... Args>
+        explicit block(Args&&... args) : value(std::forward<Args>(args)...) {}
+        std::atomic<std::size_t> refs{1};
+        // only ever set on an unshared block, so only its owner reads it
+        bool unshareable = false;
+        T value;
+    };
+    block* share() const {
+        if (block_->unshareable) return new block(block_->value);
+        retain();
+        return block_;
+    }
+    void retain() const noexcept {
+        block_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    void release() noexcept {
+        if (block_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete block_;
+    }
+    void detach() {
+        if (unique()) return;
+        block* copy = new block(block_->value);
+        release();
+        block_ = copy;
+    }
+
+    block* block_;
+};
+
+}  // namespace details
+// copy on write
+using details::cow;
+
+}  // namespace xcmixin
+
+// Define a mixin whose state is shared between copies of the class, use
+// xcmixin_state to access it: const methods read the shared state, the first
+// non-const method of a copy detaches a private one
+#define XCMIXIN_DEF_COW_BEGIN(mixin, ... /* state */)         \
+    template <typename Base, typename Derived, typename meta> \
+    struct mixin : Base {                                     \
+        XCMIXIN_INIT()                                        \
+        ::xcmixin::cow<__VA_ARGS__> xcmixin_cow_state;
+#define xcmixin_state (*this->xcmixin_cow_state)
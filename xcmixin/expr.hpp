@@ -0,0 +1,168 @@
+// expr.hpp
+// Expression template arithmetic mixins for vector like classes.
+//
+// Copyright (c) 2024 Tian Li
+// Licensed under the MIT License.
+//
+// https://github.com/X-ChenD-Hai/xcmixin
+
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#include "xcmixin.hpp"
+
+namespace xcmixin {
+namespace expr {
+// expression nodes, a node refers to the classes it reads and holds the
+// nodes and scalars it is built from by value
+template <typename T>
+concept node = requires { typename T::xcmixin_expr_node; };
+
+template <typename T>
+struct scalar {
+    using xcmixin_expr_scalar = void;
+    T value;
+    constexpr T operator[](std::size_t) const { return value; }
+};
+
+template <typename T>
+using operand_t =
+    std::conditional_t<std::is_arithmetic_v<T>, scalar<T>,
+                       std::conditional_t<node<T>, T, const T&>>;
+
+template <typename Op, typename L, typename R>
+struct binary {
+    using xcmixin_expr_node = void;
+    L l;
+    R r;
+    constexpr std::size_t size() const {
+        if constexpr (requires { typename std::remove_cvref_t<
+                                     L>::xcmixin_expr_scalar; })
+            return r.size();
+        else
+            return l.size();
+    }
+    constexpr auto operator[](std::size_t i) const { return Op{}(l[i], r[i]); }
+};
+
+template <typename Op, typename L, typename R>
+constexpr auto make_binary(const L& l, const R& r) {
+    if constexpr (!std::is_arithmetic_v<L> && !std::is_arithmetic_v<R>)
+        assert(l.size() == r.size() && "operands must have the same size");
+    return binary<Op, operand_t<L>, operand_t<R>>{l, r};
+}
+
+// evaluate e into dst in a single loop, resizing dst first when it can
+template <typename D, typename E>
+constexpr void fused_eval(D& dst, const E& e) {
+    if constexpr (requires { dst.resize(e.size()); }) {
+        if (dst.size() != e.size()) dst.resize(e.size());
+    } else {
+        assert(dst.size() == e.size() && "expression must fit the target");
+    }
+    const std::size_t n = dst.size();
+    for (std::size_t i = 0; i < n; ++i) dst[i] = e[i];
+}
+// sum of the element-wise product of l and r in a single loop
+template <typename L, typename R>
+constexpr auto dot_product(const L& l, const R& r) {
+    assert(l.size() == r.size() && "operands must have the same size");
+    using value_type = decltype(l[0] * r[0]);
+    value_type sum{};
+    const std::size_t n = l.size();
+    for (std::size_t i = 0; i < n; ++i) sum += l[i] * r[i];
+    return sum;
+}
+
+// evaluation mixin, specialize it with XCMIXIN_IMPL_FOR to replace the loop
+// for chosen expression shapes
+XCMIXIN_DEF_BEGIN(expr_eval)
+template <typename E>
+void eval(const E& e) {
+    ::xcmixin::expr::fused_eval(xcmixin_self, e);
+}
+XCMIXIN_DEF_END()
+
+// assignment mixin, assign(e) evaluates e through eval. operator= of the
+// mixin chain is hidden by the class, forward it to assign to assign with =
+XCMIXIN_DEF_BEGIN(expr_assign)
+template <typename E>
+Self& assign(const E& e) {
+    xcmixin_self.eval(e);
+    return xcmixin_self;
+}
+XCMIXIN_DEF_END()
+
+// lazy element-wise + and -, also with scalars
+XCMIXIN_DECLARE(expr_add);
+
+// lazy element-wise * and /, also with scalars
+XCMIXIN_DECLARE(expr_mul);
+
+// dot product
+XCMIXIN_DEF_BEGIN(expr_dot)
+template <typename R>
+auto dot(const R& r) const {
+    return ::xcmixin::expr::dot_product(xcmixin_const_self, r);
+}
+XCMIXIN_DEF_END()
+
+template <typename T>
+concept leaf = requires { typename T::mixin_recorder; };
+template <typename T, XCMIXIN_MIXIN_TEMPLATE_PARAM... mixins>
+concept implements = leaf<T> && is_impl<T, mixins...>;
+// anything that can be read element by element
+template <typename T>
+concept expression =
+    node<T> || implements<T, expr_eval, expr_add, expr_mul, expr_dot>;
+template <typename T>
+concept operand = expression<T> || std::is_arithmetic_v<T>;
+// an operator applies when one side allows it and the other can take part
+template <typename L, typename R, XCMIXIN_MIXIN_TEMPLATE_PARAM mixin>
+concept operands =
+    ((node<L> || implements<L, mixin>) && operand<R>) ||
+    ((node<R> || implements<R, mixin>) && operand<L>);
+
+template <typename L, typename R>
+    requires operands<L, R, expr_add>
+constexpr auto operator+(const L& l, const R& r) {
+    return make_binary<std::plus<>>(l, r);
+}
+template <typename L, typename R>
+    requires operands<L, R, expr_add>
+constexpr auto operator-(const L& l, const R& r) {
+    return make_binary<std::minus<>>(l, r);
+}
+template <typename L, typename R>
+    requires operands<L, R, expr_mul>
+constexpr auto operator*(const L& l, const R& r) {
+    return make_binary<std::multiplies<>>(l, r);
+}
+template <typename L, typename R>
+    requires operands<L, R, expr_mul>
+constexpr auto operator/(const L& l, const R& r) {
+    return make_binary<std::divides<>>(l, r);
+}
+template <expression L, expression R>
+constexpr auto dot(const L& l, const R& r) {
+    return dot_product(l, r);
+}
+
+// expression types, useful to overload eval for a shape
+template <typename L, typename R>
+using add_t = binary<std::plus<>, operand_t<L>, operand_t<R>>;
+template <typename L, typename R>
+using sub_t = binary<std::minus<>, operand_t<L>, operand_t<R>>;
+template <typename L, typename R>
+using mul_t = binary<std::multiplies<>, operand_t<L>, operand_t<R>>;
+template <typename L, typename R>
+using div_t = binary<std::divides<>, operand_t<L>, operand_t<R>>;
+
+}  // namespace expr
+}  // namespace xcmixin
+
+XCMIXIN_REQUIRE(xcmixin::expr::expr_assign,
+                xcmixin_require_mixin(::xcmixin::expr::expr_eval);)
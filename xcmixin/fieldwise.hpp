@@ -0,0 +1,293 @@
+// fieldwise.hpp
+// Equality, ordering and hashing generated from the fields of a mixin chain.
+//
+// Copyright (c) 2024 Tian Li
+// Licensed under the MIT License.
+//
+// https://github.com/X-ChenD-Hai/xcmixin
+
+#pragma once
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "xcmixin.hpp"
+
+namespace xcmixin {
+namespace details {
+// class that declares a member
+template <typename T>
+struct member_owner_of;
+template <typename M, typename C>
+struct member_owner_of<M C::*> : return_type<C> {};
+
+// base class parameter of a mixin layer
+template <typename layer>
+struct layer_base : invalid_value_type<layer> {};
+template <template <typename, typename, typename> class m, typename B,
+          typename D, typename meta>
+struct layer_base<m<B, D, meta>> : return_type<B> {};
+
+// befriended by xcmixin_fields, so field lists declared in a private section
+// are found instead of silently skipped
+struct field_access {
+    // whether T itself, not one of the classes below Below, declares fields
+    template <typename T, typename Below>
+    static constexpr bool declares() {
+        if constexpr (requires { &T::xcmixin_field_tie; })
+            return !std::is_base_of_v<deref_type<member_owner_of<decltype(
+                                          &T::xcmixin_field_tie)>>,
+                                      Below>;
+        else
+            return false;
+    }
+    template <typename T>
+    static auto tie(const T& object) {
+        return object.xcmixin_field_tie();
+    }
+};
+template <typename T, typename Below>
+constexpr bool declares_fields = field_access::declares<T, Below>();
+
+template <typename T>
+auto own_fields(const T& object) {
+    return field_access::tie(object);
+}
+
+// fields of every layer of the chain starting at link, in chain order
+template <typename link>
+auto chain_fields(const link& object) {
+    using layer = typename link::xcmixin_layer;
+    using below = deref_type<layer_base<layer>>;
+    auto below_fields = [&] {
+        if constexpr (requires { typename below::xcmixin_layer; })
+            return chain_fields(static_cast<const below&>(object));
+        else
+            return std::tuple<>{};
+    };
+    if constexpr (declares_fields<layer, below>)
+        return std::tuple_cat(own_fields(static_cast<const layer&>(object)),
+                              below_fields());
+    else
+        return below_fields();
+}
+
+// fields of T, those of its mixin layers and those T declares itself
+template <typename T>
+auto fields_of(const T& object) {
+    using chain = typename T::xcmixin_self_class;
+    if constexpr (declares_fields<T, chain>)
+        return std::tuple_cat(own_fields(object),
+                              chain_fields(static_cast<const chain&>(object)));
+    else
+        return chain_fields(static_cast<const chain&>(object));
+}
+template <typename T>
+using fields_type = decltype(fields_of(std::declval<const T&>()));
+
+template <typename T>
+concept has_fields =
+    requires { typename T::xcmixin_self_class::xcmixin_layer; };
+
+// the fields cover every byte of T and equal values have equal bytes, so
+// equality and hashing can work on the object representation
+template <typename fields>
+constexpr std::size_t fields_size = 0;
+template <typename... F>
+constexpr std::size_t fields_size<std::tuple<F...>> =
+    (std::size_t{0} + ... + sizeof(std::remove_reference_t<F>));
+template <typename T>
+constexpr bool is_bitwise_comparable =
+    std::has_unique_object_representations_v<T> &&
+    fields_size<fields_type<T>> == sizeof(T);
+
+// whether the fields are distinct data members of object, the sizes only
+// match the bytes of T when no field is repeated or lives outside of it
+template <typename T>
+bool fields_are_members(const T& object) {
+    const char* first = reinterpret_cast<const char*>(std::addressof(object));
+    return std::apply(
+        [&](const auto&... fields) {
+            const char* begin[] = {
+                reinterpret_cast<const char*>(std::addressof(fields))...};
+            const std::size_t size[] = {sizeof(fields)...};
+            for (std::size_t i = 0; i < sizeof...(fields); ++i) {
+                if (begin[i] < first || begin[i] + size[i] > first + sizeof(T))
+                    return false;
+                for (std::size_t j = 0; j < i; ++j)
+                    if (begin[i] < begin[j] + size[j] &&
+                        begin[j] < begin[i] + size[i])
+                        return false;
+            }
+            return true;
+        },
+        fields_of(object));
+}
+
+// word at a time hash over four independent lanes
+inline std::size_t hash_bytes(const void* data, std::size_t size) noexcept {
+    constexpr std::uint64_t k = 0x9e3779b97f4a7c15ull;
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    auto mix = [](std::uint64_t h, std::uint64_t word) {
+        h = (h ^ word) * k;
+        return h ^ (h >> 29);
+    };
+    std::uint64_t lanes[4] = {k, k + 1, k + 2, k + 3};
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (std::size_t lane = 0; lane < 4; ++lane) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i + lane * 8, 8);
+            lanes[lane] = mix(lanes[lane], word);
+        }
+    }
+    std::uint64_t h = mix(k, size);
+    for (std::uint64_t lane : lanes) h = mix(h, lane);
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        h = mix(h, word);
+    }
+    if (i < size) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bytes + i, size - i);
+        h = mix(h, word);
+    }
+    return static_cast<std::size_t>(h ^ (h >> 32));
+}
+
+template <typename T>
+struct hash;
+
+// single field operations, arrays are compared and hashed element by element
+// instead of decaying to pointers
+template <typename F>
+bool field_equal(const F& l, const F& r) {
+    if constexpr (std::is_array_v<F>) {
+        for (std::size_t i = 0; i < std::extent_v<F>; ++i)
+            if (!field_equal(l[i], r[i])) return false;
+        return true;
+    } else {
+        return l == r;
+    }
+}
+template <typename F>
+auto field_compare(const F& l, const F& r) {
+    if constexpr (std::is_array_v<F>) {
+        using result = decltype(field_compare(l[0], r[0]));
+        for (std::size_t i = 0; i < std::extent_v<F>; ++i)
+            if (result c = field_compare(l[i], r[i]); c != 0) return c;
+        return result::equivalent;
+    } else if constexpr (std::three_way_comparable<F>) {
+        return l <=> r;
+    } else {
+        return l < r   ? std::weak_ordering::less
+               : r < l ? std::weak_ordering::greater
+                       : std::weak_ordering::equivalent;
+    }
+}
+inline std::size_t hash_combine(std::size_t h, std::size_t value) {
+    return h ^ (value + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2));
+}
+template <typename F>
+std::size_t field_hash(const F& field) {
+    if constexpr (std::is_array_v<F>) {
+        std::size_t h = 0;
+        for (const auto& element : field)
+            h = hash_combine(h, field_hash(element));
+        return h;
+    } else {
+        return hash<F>{}(field);
+    }
+}
+
+template <typename T>
+bool fieldwise_equal(const T& l, const T& r) {
+    if constexpr (is_bitwise_comparable<T>) {
+        assert(fields_are_members(l) &&
+               "xcmixin_fields must list distinct non-static data members");
+        return std::memcmp(&l, &r, sizeof(T)) == 0;
+    } else {
+        auto lf = fields_of(l), rf = fields_of(r);
+        return [&]<std::size_t... i>(std::index_sequence<i...>) {
+            return (field_equal(std::get<i>(lf), std::get<i>(rf)) && ...);
+        }(std::make_index_sequence<std::tuple_size_v<decltype(lf)>>{});
+    }
+}
+template <typename T>
+auto fieldwise_compare(const T& l, const T& r) {
+    auto lf = fields_of(l), rf = fields_of(r);
+    return [&]<std::size_t... i>(std::index_sequence<i...>) {
+        using result = std::common_comparison_category_t<decltype(
+            field_compare(std::get<i>(lf), std::get<i>(rf)))...>;
+        // the first field that differs decides
+        result c = result::equivalent;
+        (void)(((c = field_compare(std::get<i>(lf), std::get<i>(rf))) == 0) &&
+               ...);
+        return c;
+    }(std::make_index_sequence<std::tuple_size_v<decltype(lf)>>{});
+}
+template <typename T>
+std::size_t fieldwise_hash(const T& object) {
+    if constexpr (is_bitwise_comparable<T>) {
+        assert(fields_are_members(object) &&
+               "xcmixin_fields must list distinct non-static data members");
+        return hash_bytes(&object, sizeof(T));
+    } else {
+        return std::apply(
+            [](const auto&... fields) {
+                std::size_t h = 0;
+                ((h = hash_combine(h, field_hash(fields))), ...);
+                return h;
+            },
+            fields_of(object));
+    }
+}
+
+// hash functor, generated from the fields of mixin chains and std::hash for
+// other types
+template <typename T>
+struct hash {
+    std::size_t operator()(const T& value) const {
+        if constexpr (has_fields<T>)
+            return fieldwise_hash(value);
+        else
+            return std::hash<T>{}(value);
+    }
+};
+
+}  // namespace details
+// traits
+using details::is_bitwise_comparable;
+// fieldwise
+using details::fields_of;
+using details::hash;
+
+namespace fieldwise {
+// comparison mixin, == and <=> over the fields of every layer
+XCMIXIN_DEF_BEGIN(compare)
+friend bool operator==(const Self& l, const Self& r) {
+    return ::xcmixin::details::fieldwise_equal(l, r);
+}
+friend auto operator<=>(const Self& l, const Self& r) {
+    return ::xcmixin::details::fieldwise_compare(l, r);
+}
+XCMIXIN_DEF_END()
+}  // namespace fieldwise
+
+}  // namespace xcmixin
+
+// Declare the data members of a mixin or class that take part in the
+// generated comparison and hashing, in order, also from a private section.
+// list each non-static data member at most once, the memcmp fast path asserts
+// it in debug builds
+#define xcmixin_fields(...)                                          \
+    friend struct ::xcmixin::details::field_access;                  \
+    auto xcmixin_field_tie() const { return std::tie(__VA_ARGS__); }
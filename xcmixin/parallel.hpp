@@ -0,0 +1,266 @@
+// parallel.hpp
+// Parallel algorithms over ranges of mixin composed objects.
+//
+// Copyright (c) 2024 Tian Li
+// Licensed under the MIT License.
+//
+// https://github.com/X-ChenD-Hai/xcmixin
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xcmixin.hpp"
+
+namespace xcmixin {
+namespace details {
+inline constexpr std::size_t cache_line_size = 64;
+
+// one thread's share of a job, a half-open range of chunk indices. the owner
+// pops chunks from the front, thieves take the back half at once
+struct alignas(cache_line_size) work_queue {
+    std::mutex mutex;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+
+    bool pop(std::size_t& chunk) {
+        std::lock_guard lock(mutex);
+        if (begin == end) return false;
+        chunk = begin++;
+        return true;
+    }
+    bool steal_from(work_queue& victim) {
+        std::size_t first, last;
+        {
+            std::lock_guard lock(victim.mutex);
+            std::size_t count = victim.end - victim.begin;
+            if (count == 0) return false;
+            last = victim.end;
+            first = last - (count + 1) / 2;
+            victim.end = first;
+        }
+        std::lock_guard lock(mutex);
+        begin = first;
+        end = last;
+        return true;
+    }
+};
+
+// work stealing thread pool, the calling thread takes part in every job
+class thread_pool {
+   public:
+    explicit thread_pool(
+        std::size_t concurrency = std::thread::hardware_concurrency())
+        : size_(concurrency == 0 ? 1 : concurrency),
+          queues_(new work_queue[size_]) {
+        threads_.reserve(size_ - 1);
+        for (std::size_t i = 1; i < size_; ++i)
+            threads_.emplace_back([this, i] { worker_main(i); });
+    }
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    ~thread_pool() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& thread : threads_) thread.join();
+    }
+
+    // number of threads taking part in a job, including the caller
+    std::size_t concurrency() const noexcept { return size_; }
+
+    // call task(i) for every i in [0, chunks) and wait for all of them, the
+    // first exception thrown by a task is rethrown here
+    template <typename F>
+    void run(std::size_t chunks, F&& task) {
+        if (chunks == 0) return;
+        if (chunks == 1 || size_ == 1 || in_worker()) {
+            for (std::size_t i = 0; i < chunks; ++i) task(i);
+            return;
+        }
+        std::lock_guard run_lock(run_mutex_);
+        for (std::size_t i = 0; i < size_; ++i) {
+            std::lock_guard lock(queues_[i].mutex);
+            queues_[i].begin = chunks * i / size_;
+            queues_[i].end = chunks * (i + 1) / size_;
+        }
+        context_ = std::addressof(task);
+        invoke_ = [](void* context, std::size_t chunk) {
+            (*static_cast<std::remove_reference_t<F>*>(context))(chunk);
+        };
+        failed_.store(false, std::memory_order_relaxed);
+        {
+            std::lock_guard lock(mutex_);
+            ++generation_;
+            active_ = size_ - 1;
+        }
+        wake_.notify_all();
+        work(0);
+        {
+            std::unique_lock lock(mutex_);
+            done_.wait(lock, [this] { return active_ == 0; });
+        }
+        if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+
+    // process wide pool sized to the hardware concurrency
+    static thread_pool& instance() {
+        static thread_pool pool;
+        return pool;
+    }
+
+   private:
+    static bool& in_worker() {
+        thread_local bool flag = false;
+        return flag;
+    }
+    void work(std::size_t self) {
+        in_worker() = true;
+        std::size_t chunk;
+        for (;;) {
+            if (!queues_[self].pop(chunk)) {
+                bool stolen = false;
+                for (std::size_t i = 1; i < size_ && !stolen; ++i)
+                    stolen = queues_[self].steal_from(
+                        queues_[(self + i) % size_]);
+                if (!stolen) break;
+                continue;
+            }
+            if (failed_.load(std::memory_order_relaxed)) continue;
+            try {
+                invoke_(context_, chunk);
+            } catch (...) {
+                std::lock_guard lock(mutex_);
+                if (!failed_.exchange(true)) error_ = std::current_exception();
+            }
+        }
+        in_worker() = false;
+    }
+    void worker_main(std::size_t self) {
+        std::size_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock,
+                           [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+            }
+            work(self);
+            {
+                std::lock_guard lock(mutex_);
+                if (--active_ == 0) done_.notify_one();
+            }
+        }
+    }
+
+    std::size_t size_;
+    std::unique_ptr<work_queue[]> queues_;
+    std::vector<std::thread> threads_;
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::size_t generation_ = 0;
+    std::size_t active_ = 0;
+    bool stop_ = false;
+    void* context_ = nullptr;
+    void (*invoke_)(void*, std::size_t) = nullptr;
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;
+};
+
+// a chain may be called in parallel over distinct objects when every mixin in
+// it is at least per object safe
+template <typename T, typename = void>
+constexpr bool is_parallel_safe = false;
+template <typename T>
+constexpr bool
+    is_parallel_safe<T, std::void_t<typename T::mixin_recorder>> =
+        is_concurrent<T, concurrency::per_object_>;
+
+// chunk size in elements, a multiple of a cache line worth of elements and
+// about eight chunks per thread so stealing can balance uneven work
+template <typename T>
+constexpr std::size_t chunk_size(std::size_t count, std::size_t threads) {
+    constexpr std::size_t line =
+        sizeof(T) >= cache_line_size ? 1 : cache_line_size / sizeof(T);
+    std::size_t chunk = (count + threads * 8 - 1) / (threads * 8);
+    return (chunk + line - 1) / line * line;
+}
+
+// elements before the first chunk boundary so that every boundary of a
+// contiguous range falls on a cache line, 0 when elements do not tile lines
+template <typename R>
+std::size_t chunk_shift(R& range, std::size_t chunk) {
+    using object = std::remove_cvref_t<std::ranges::range_reference_t<R>>;
+    if constexpr (std::ranges::contiguous_range<R> &&
+                  cache_line_size % sizeof(object) == 0) {
+        auto address = reinterpret_cast<std::uintptr_t>(
+            std::to_address(std::ranges::begin(range)));
+        if (address % sizeof(object) != 0) return 0;
+        std::size_t head = (cache_line_size - address % cache_line_size) %
+                           cache_line_size / sizeof(object);
+        return (chunk - head % chunk) % chunk;
+    } else {
+        return 0;
+    }
+}
+
+// call method on every object of range, spread over the threads of pool
+template <auto method, std::ranges::random_access_range R, typename... Args>
+void parallel_for_each(thread_pool& pool, R&& range, const Args&... args) {
+    using object = std::remove_cvref_t<std::ranges::range_reference_t<R>>;
+    static_assert(
+        std::is_lvalue_reference_v<std::ranges::range_reference_t<R>>,
+        "range must refer to its objects");
+    static_assert(is_parallel_safe<object>,
+                  "every mixin of the object must be declared read_only_ or "
+                  "per_object_ by XCMIXIN_CONCURRENCY");
+    static_assert(std::is_invocable_v<decltype(method),
+                                      std::ranges::range_reference_t<R>,
+                                      const Args&...>,
+                  "method must be callable on the objects of range");
+    auto first = std::ranges::begin(range);
+    std::size_t count = static_cast<std::size_t>(std::ranges::distance(range));
+    if (count == 0) return;
+    std::size_t chunk = chunk_size<object>(count, pool.concurrency());
+    // chunk i covers [i * chunk, (i + 1) * chunk) shifted back by shift
+    std::size_t shift = chunk_shift(range, chunk);
+    pool.run((count + shift + chunk - 1) / chunk, [&](std::size_t i) {
+        auto it = first + static_cast<std::ptrdiff_t>(
+                              i == 0 ? 0 : i * chunk - shift);
+        auto last = first + static_cast<std::ptrdiff_t>(
+                                std::min(count, (i + 1) * chunk - shift));
+        for (; it != last; ++it) std::invoke(method, *it, args...);
+    });
+}
+template <auto method, std::ranges::random_access_range R, typename... Args>
+void parallel_for_each(R&& range, const Args&... args) {
+    parallel_for_each<method>(thread_pool::instance(), std::forward<R>(range),
+                              args...);
+}
+
+}  // namespace details
+// traits
+using details::is_parallel_safe;
+// parallel
+using details::parallel_for_each;
+using details::thread_pool;
+
+}  // namespace xcmixin
@@ -0,0 +1,171 @@
+// state_machine.hpp
+// Static state machine whose states are mixins.
+//
+// Copyright (c) 2024 Tian Li
+// Licensed under the MIT License.
+//
+// https://github.com/X-ChenD-Hai/xcmixin
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "xcmixin.hpp"
+
+#define MIXIN XCMIXIN_MIXIN_TEMPLATE_PARAM
+namespace xcmixin {
+// allowed transitions out of a state mixin, a state without declaration can
+// not leave
+template <typename meta>
+struct state_transitions {
+    using type = details::mixin_recorder<>;
+};
+
+namespace details {
+// root of a state layer, every state of a machine is a distinct base class so
+// that handlers of different states never hide each other
+template <typename Derived, typename meta>
+struct state_root {
+    using mixin_recorder = details::mixin_recorder<>;
+    template <typename D = Derived>
+    constexpr static bool valid_class() {
+        return true;
+    }
+};
+template <typename Derived, MIXIN state>
+using state_layer =
+    state<state_root<Derived, meta_mixin<state>>, Derived, meta_mixin<state>>;
+template <typename Derived, typename meta>
+struct state_layer_of_helper;
+template <typename Derived, typename meta>
+using state_layer_of = deref_type<state_layer_of_helper<Derived, meta>>;
+template <typename Derived, MIXIN state>
+struct state_layer_of_helper<Derived, meta_mixin<state>>
+    : return_type<state_layer<Derived, state>> {};
+
+// base class of the non state mixins of a machine
+template <typename Derived, typename... recorders>
+struct state_chain_helper : return_type<impl_recorder<Derived, recorders...>> {
+};
+template <typename Derived>
+struct state_chain_helper<Derived>
+    : return_type<state_root<Derived, mixin_recorder<>>> {};
+
+// position of the state described by meta in the machine
+template <typename meta, typename states>
+static constexpr std::size_t state_index = invalid_value<meta, std::size_t>;
+template <MIXIN state, typename states>
+static constexpr std::size_t state_index<meta_mixin<state>, states> =
+    mixin_index<state, states>;
+
+// state machine generator, inherit state_machine<...> to mixin all states and
+// the mixins in recorders
+template <typename Derived, typename states, typename... recorders>
+struct state_machine_helper;
+template <typename Derived, typename states, typename... recorders>
+using state_machine =
+    deref_type<state_machine_helper<Derived, states, recorders...>>;
+template <typename Derived, MIXIN... states, typename... recorders>
+struct state_machine_helper<Derived, mixin_recorder<states...>, recorders...> {
+    static_assert(sizeof...(states) > 0, "state machine needs a state");
+    using chain = deref_type<state_chain_helper<Derived, recorders...>>;
+    using state_list = mixin_recorder<states...>;
+    using index_type = std::conditional_t<(sizeof...(states) <= 0xff),
+                                          std::uint8_t, std::uint16_t>;
+
+    struct type : chain, state_layer<Derived, states>... {
+        using xcmixin_self_class = type;
+        using mixin_recorder =
+            recorder_concat<typename state_layer<Derived, states>::
+                                mixin_recorder::template push_front<states>...,
+                            typename chain::mixin_recorder>;
+        template <typename D = Derived>
+        constexpr static bool valid_class() {
+            return chain::valid_class() &&
+                   (... && (::xcmixin::mixin_validator<meta_mixin<states>>::
+                                    template valid_mixin<
+                                        state_layer<Derived, states>,
+                                        Derived>() &&
+                            vaild_base_class<state_layer<Derived, states>,
+                                             Derived> &&
+                            state_layer<Derived, states>::valid_class()));
+        }
+
+        // send event to the active state, return whether the state handles it
+        template <typename Event>
+        bool dispatch(Event&& event) {
+            using event_type = std::remove_reference_t<Event>;
+            static_assert((... || handles<states, event_type>),
+                          "no state handles the event");
+            static constexpr bool (*table[])(type&, event_type&) = {
+                &handle<states, event_type>...};
+            return table[index_](*this, event);
+        }
+        template <MIXIN state>
+        bool in_state() const noexcept {
+            return index_ == mixin_index<state, state_list>;
+        }
+        std::size_t state_index() const noexcept { return index_; }
+
+        // switch the active state, called by xcmixin_transition from the
+        // handlers of the state described by from_meta
+        template <typename from_meta, MIXIN to>
+        void xcmixin_switch_state() {
+            constexpr std::size_t from =
+                details::state_index<from_meta, state_list>;
+            static_assert(from < sizeof...(states),
+                          "transition must start from a state of the machine");
+            static_assert(has_mixin<to, state_list>,
+                          "transition must end in a state of the machine");
+            static_assert(
+                has_mixin<to, typename ::xcmixin::state_transitions<
+                                  from_meta>::type>,
+                "transition is not declared by XCMIXIN_TRANSITIONS");
+            using from_layer = state_layer_of<Derived, from_meta>;
+            using to_layer = state_layer<Derived, to>;
+            if constexpr (requires(from_layer& l) { l.on_exit(); })
+                static_cast<from_layer&>(*this).on_exit();
+            index_ = static_cast<index_type>(mixin_index<to, state_list>);
+            if constexpr (requires(to_layer& l) { l.on_enter(); })
+                static_cast<to_layer&>(*this).on_enter();
+        }
+
+       private:
+        template <MIXIN state, typename event_type>
+        static constexpr bool handles =
+            requires(state_layer<Derived, state>& l, event_type& e) {
+                l.on_event(e);
+            };
+        template <MIXIN state, typename event_type>
+        static bool handle(type& self, event_type& event) {
+            if constexpr (handles<state, event_type>) {
+                static_cast<state_layer<Derived, state>&>(self).on_event(event);
+                return true;
+            } else {
+                return false;
+            }
+        }
+
+        index_type index_ = 0;
+    };
+};
+
+}  // namespace details
+// state machine
+using details::state_machine;
+
+}  // namespace xcmixin
+#undef MIXIN
+
+// Declare the states a state mixin may transition to
+#define XCMIXIN_TRANSITIONS(name, ...)                            \
+    namespace xcmixin {                                           \
+    template <>                                                   \
+    struct state_transitions<::xcmixin::meta_mixin<name>> {       \
+        using type = ::xcmixin::mixin_recorder<__VA_ARGS__>;      \
+    };                                                            \
+    }
+// Switch the machine from the current state mixin to another state
+#define xcmixin_transition(state) \
+    xcmixin_self.template xcmixin_switch_state<meta, state>()
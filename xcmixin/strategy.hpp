@@ -0,0 +1,63 @@
+// strategy.hpp
+// Runtime selection between classes instantiated with different strategy
+// mixins.
+//
+// Copyright (c) 2024 Tian Li
+// Licensed under the MIT License.
+//
+// https://github.com/X-ChenD-Hai/xcmixin
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "xcmixin.hpp"
+
+#define MIXIN XCMIXIN_MIXIN_TEMPLATE_PARAM
+namespace xcmixin {
+namespace details {
+// strategy switch, instantiate Derived with every strategy in recorder and
+// select one of them by index through a jump table
+template <template <MIXIN> class Derived, typename recorder>
+struct strategy_switch;
+template <template <MIXIN> class Derived, MIXIN... strategies>
+struct strategy_switch<Derived, mixin_recorder<strategies...>> {
+    static_assert(sizeof...(strategies) > 0,
+                  "strategy switch needs a strategy");
+    static constexpr std::size_t size = sizeof...(strategies);
+    template <MIXIN strategy>
+    static constexpr std::size_t index_of =
+        mixin_index<strategy, mixin_recorder<strategies...>>;
+
+    // construct Derived<strategy> of the index-th strategy from args and call
+    // f with it, hoist hot loops into f so the calls inside stay static
+    template <typename F, typename... Args>
+    static decltype(auto) dispatch(std::size_t index, F&& f, Args&&... args) {
+        using result = std::common_type_t<
+            std::invoke_result_t<F, Derived<strategies>&>...>;
+        if (index >= size)
+            throw std::out_of_range("xcmixin: strategy index out of range");
+        static constexpr result (*table[])(std::remove_reference_t<F>&,
+                                           std::remove_reference_t<Args>&...) =
+            {&invoke<strategies, result, F, Args...>...};
+        return table[index](f, args...);
+    }
+
+   private:
+    template <MIXIN strategy, typename result, typename F, typename... Args>
+    static result invoke(std::remove_reference_t<F>& f,
+                         std::remove_reference_t<Args>&... args) {
+        Derived<strategy> object(std::forward<Args>(args)...);
+        return std::invoke(std::forward<F>(f), object);
+    }
+};
+
+}  // namespace details
+// strategy
+using details::strategy_switch;
+
+}  // namespace xcmixin
+#undef MIXIN
@@ -0,0 +1,394 @@
+// sync.hpp
+// Per mixin locking for objects shared between threads.
+//
+// Copyright (c) 2024 Tian Li
+// Licensed under the MIT License.
+//
+// https://github.com/X-ChenD-Hai/xcmixin
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "xcmixin.hpp"
+
+#define MIXIN XCMIXIN_MIXIN_TEMPLATE_PARAM
+namespace xcmixin {
+// lock declaration of a mixin, declared by XCMIXIN_LOCK. undeclared mixins
+// are not guarded
+template <typename meta>
+struct mixin_lock {};
+
+namespace sync {
+// locks, writers call lock() and unlock(), readers call read(f). reads return
+// by value so no reference to guarded data outlives the lock
+
+// one writer or one reader at a time
+class mutex_lock {
+   public:
+    void lock() { mutex_.lock(); }
+    void unlock() { mutex_.unlock(); }
+    template <typename F>
+    auto read(F&& f) {
+        std::lock_guard guard(mutex_);
+        return std::invoke(std::forward<F>(f));
+    }
+
+   private:
+    std::mutex mutex_;
+};
+
+// one writer or many readers at a time
+class rw_lock {
+   public:
+    void lock() { mutex_.lock(); }
+    void unlock() { mutex_.unlock(); }
+    template <typename F>
+    auto read(F&& f) {
+        std::shared_lock guard(mutex_);
+        return std::invoke(std::forward<F>(f));
+    }
+
+   private:
+    std::shared_mutex mutex_;
+};
+
+// state of a mixin guarded by seq_lock, stored as words that are only read and
+// written through relaxed atomics, so readers racing a writer see torn values
+// that seq_lock discards instead of undefined behaviour
+template <typename T>
+class seq_data {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "seq_lock only guards trivially copyable state");
+    static constexpr std::size_t size = (sizeof(T) + 7) / 8;
+
+   public:
+    seq_data() : seq_data(T{}) {}
+    explicit seq_data(const T& value) { store(value); }
+
+    T load() const noexcept {
+        std::uint64_t copy[size];
+        for (std::size_t i = 0; i < size; ++i)
+            copy[i] = std::atomic_ref<std::uint64_t>(words_[i]).load(
+                std::memory_order_relaxed);
+        T value;
+        std::memcpy(&value, copy, sizeof(T));
+        return value;
+    }
+    void store(const T& value) noexcept {
+        std::uint64_t copy[size] = {};
+        std::memcpy(copy, &value, sizeof(T));
+        for (std::size_t i = 0; i < size; ++i)
+            std::atomic_ref<std::uint64_t>(words_[i]).store(
+                copy[i], std::memory_order_relaxed);
+    }
+
+   private:
+    alignas(std::atomic_ref<std::uint64_t>::required_alignment)
+        mutable std::uint64_t words_[size];
+};
+
+// readers never write the lock, they retry when a writer ran meanwhile. the
+// guarded mixin keeps its state in seq_data<T>, declare it with
+// XCMIXIN_DEF_SEQ_BEGIN. reads must be free of side effects
+template <typename T>
+class seq_lock {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "seq_lock only guards trivially copyable state");
+
+   public:
+    using state = T;
+
+    void lock() noexcept {
+        std::uint64_t seq = seq_.load(std::memory_order_relaxed);
+        for (;;) {
+            if (seq & 1) {
+                std::this_thread::yield();
+                seq = seq_.load(std::memory_order_relaxed);
+            } else if (seq_.compare_exchange_weak(seq, seq + 1,
+                                                  std::memory_order_acquire,
+                                                  std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    void unlock() noexcept { seq_.fetch_add(1, std::memory_order_release); }
+    template <typename F>
+    auto read(F&& f) {
+        using result = std::invoke_result_t<F&>;
+        static_assert(!std::is_void_v<result> && !std::is_reference_v<result>,
+                      "seq_lock reads must return by value");
+        for (;;) {
+            std::uint64_t seq = seq_.load(std::memory_order_acquire);
+            if (seq & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            result value = std::invoke(f);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == seq) return value;
+        }
+    }
+
+   private:
+    std::atomic<std::uint64_t> seq_{0};
+};
+}  // namespace sync
+
+namespace details {
+// default lock group of a mixin is the mixin itself
+template <typename meta, typename group = meta>
+struct lock_group : return_type<group> {};
+
+template <typename group_, typename lock_>
+struct lock_entry {
+    using group = group_;
+    using lock = lock_;
+};
+template <typename meta, typename = void>
+struct lock_entry_of : return_type<void> {};
+template <typename meta>
+struct lock_entry_of<meta,
+                     std::void_t<typename ::xcmixin::mixin_lock<meta>::lock>>
+    : return_type<lock_entry<typename ::xcmixin::mixin_lock<meta>::group,
+                             typename ::xcmixin::mixin_lock<meta>::lock>> {};
+
+// lock entries of a recorder, one per group
+template <typename entries, typename... rest>
+struct unique_entries_helper : return_type<entries> {};
+template <typename... entries, typename... rest>
+struct unique_entries_helper<fn::type_list<entries...>, void, rest...>
+    : unique_entries_helper<fn::type_list<entries...>, rest...> {};
+template <typename... entries, typename group, typename lock,
+          typename... rest>
+struct unique_entries_helper<fn::type_list<entries...>,
+                             lock_entry<group, lock>, rest...>
+    : unique_entries_helper<
+          std::conditional_t<
+              (false || ... || std::is_same_v<group, typename entries::group>),
+              fn::type_list<entries...>,
+              fn::type_list<entries..., lock_entry<group, lock>>>,
+          rest...> {
+    static_assert((true && ... &&
+                   (!std::is_same_v<group, typename entries::group> ||
+                    std::is_same_v<lock, typename entries::lock>)),
+                  "mixins sharing a lock group must declare the same lock");
+};
+
+// one lock per group, each on its own cache line. copies of the table start
+// unlocked instead of copying the locks
+template <typename entries>
+struct lock_table;
+template <typename... entries>
+struct lock_table<fn::type_list<entries...>> {
+    template <typename lock>
+    struct alignas(64) padded {
+        lock value;
+    };
+    std::tuple<padded<typename entries::lock>...> locks;
+
+    lock_table() = default;
+    lock_table(const lock_table&) : lock_table() {}
+    lock_table& operator=(const lock_table&) { return *this; }
+
+    template <typename group>
+    static constexpr std::size_t index_of = [] {
+        constexpr bool same[] = {
+            std::is_same_v<group, typename entries::group>..., true};
+        std::size_t index = 0;
+        while (!same[index]) ++index;
+        return index;
+    }();
+    template <typename group>
+    auto& get() {
+        static_assert(index_of<group> < sizeof...(entries),
+                      "mixin is not guarded by XCMIXIN_LOCK");
+        // keep the index in range so the assertion is the only error
+        return std::get<std::min(index_of<group>, sizeof...(entries) - 1)>(
+                   locks)
+            .value;
+    }
+};
+
+template <typename recorder>
+struct recorder_lock_table_helper;
+template <MIXIN... mixins>
+struct recorder_lock_table_helper<mixin_recorder<mixins...>>
+    : return_type<lock_table<deref_type<unique_entries_helper<
+          fn::type_list<>,
+          deref_type<lock_entry_of<meta_mixin<mixins>>>...>>>> {};
+
+// state guarded by a seq_lock, void for other locks
+template <typename lock>
+struct seq_lock_state : return_type<void> {};
+template <typename T>
+struct seq_lock_state<::xcmixin::sync::seq_lock<T>> : return_type<T> {};
+template <typename lock, typename T = deref_type<seq_lock_state<lock>>>
+constexpr bool is_valid_lock =
+    std::is_void_v<T> || std::is_trivially_copyable_v<T>;
+
+// group of a mixin declared by XCMIXIN_LOCK, void when it is not guarded
+template <typename meta, typename = void>
+struct guarded_group : return_type<void> {};
+template <typename meta>
+struct guarded_group<meta,
+                     std::void_t<typename ::xcmixin::mixin_lock<meta>::group>>
+    : return_type<typename ::xcmixin::mixin_lock<meta>::group> {};
+
+// meta of the mixin layer that declares a method, void when the class itself
+// declares it
+template <typename T>
+struct member_class;
+template <typename M, typename C>
+struct member_class<M C::*> : return_type<C> {};
+template <typename layer>
+struct layer_meta : return_type<void> {};
+template <template <typename, typename, typename> class m, typename B,
+          typename D, typename meta>
+struct layer_meta<m<B, D, meta>> : return_type<meta> {};
+template <auto method>
+using method_layer = deref_type<member_class<decltype(method)>>;
+template <auto method>
+using method_meta = deref_type<layer_meta<method_layer<method>>>;
+template <auto method>
+using method_group = deref_type<guarded_group<method_meta<method>>>;
+template <auto method>
+constexpr bool is_layer_method = !std::is_void_v<method_meta<method>>;
+
+// a seq_lock layer holds nothing but its seq_data, any other member would be
+// read racing the writer
+template <typename B, typename T>
+struct seq_layer_probe : B {
+    ::xcmixin::sync::seq_data<T> xcmixin_seq_state;
+};
+template <typename layer, typename T>
+constexpr bool is_seq_layer = false;
+template <template <typename, typename, typename> class m, typename B,
+          typename D, typename meta, typename T>
+    requires std::is_same_v<decltype(m<B, D, meta>::xcmixin_seq_state),
+                            ::xcmixin::sync::seq_data<T>>
+constexpr bool is_seq_layer<m<B, D, meta>, T> =
+    sizeof(m<B, D, meta>) == sizeof(seq_layer_probe<B, T>);
+template <auto method, typename lock>
+constexpr bool is_valid_seq_method = [] {
+    using T = deref_type<seq_lock_state<lock>>;
+    if constexpr (std::is_void_v<T> || std::is_void_v<method_group<method>>)
+        return true;
+    else
+        return is_seq_layer<method_layer<method>, T>;
+}();
+
+// const methods read, every other method writes
+template <auto method, typename T, typename... Args>
+using method_category =
+    std::conditional_t<std::is_invocable_v<decltype(method), const T&, Args...>,
+                       member_category::const_,
+                       member_category::non_const_volatile_>;
+
+template <typename T, typename = void>
+struct recorder_of : return_type<mixin_recorder<>> {};
+template <typename T>
+struct recorder_of<T, std::void_t<typename T::mixin_recorder>>
+    : return_type<typename T::mixin_recorder> {};
+template <typename T>
+using lock_table_of =
+    deref_type<recorder_lock_table_helper<deref_type<recorder_of<T>>>>;
+
+}  // namespace details
+
+namespace sync {
+// guard mixin, holds the locks of the guarded mixins after it in the recorder
+// and calls their methods under the lock of their group
+XCMIXIN_DEF_BEGIN(guarded)
+// call a method of a guarded mixin, const methods take the read side of the
+// lock and the others the write side
+template <auto method, typename... Args>
+decltype(auto) locked(Args&&... args) {
+    static_assert(::xcmixin::details::is_layer_method<method>,
+                  "method must be declared by a guarded mixin, not the class");
+    auto& lock = xcmixin_locks_.template get<
+        ::xcmixin::details::method_group<method>>();
+    static_assert(::xcmixin::details::is_valid_seq_method<
+                      method, std::remove_reference_t<decltype(lock)>>,
+                  "a seq_lock mixin must keep all its state in the seq_data "
+                  "declared by XCMIXIN_DEF_SEQ_BEGIN");
+    if constexpr (std::is_same_v<::xcmixin::details::method_category<
+                                     method, Self, Args&&...>,
+                                 ::xcmixin::const_>) {
+        return lock.read([&]() -> decltype(auto) {
+            return std::invoke(method, xcmixin_const_self,
+                               std::forward<Args>(args)...);
+        });
+    } else {
+        std::lock_guard guard(lock);
+        return std::invoke(method, xcmixin_self, std::forward<Args>(args)...);
+    }
+}
+template <auto method, typename... Args>
+decltype(auto) locked(Args&&... args) const {
+    static_assert(::xcmixin::details::is_layer_method<method>,
+                  "method must be declared by a guarded mixin, not the class");
+    static_assert(std::is_same_v<::xcmixin::details::method_category<
+                                     method, Self, Args&&...>,
+                                 ::xcmixin::const_>,
+                  "only const methods can be called on a const object");
+    auto& lock = xcmixin_locks_.template get<
+        ::xcmixin::details::method_group<method>>();
+    static_assert(::xcmixin::details::is_valid_seq_method<
+                      method, std::remove_reference_t<decltype(lock)>>,
+                  "a seq_lock mixin must keep all its state in the seq_data "
+                  "declared by XCMIXIN_DEF_SEQ_BEGIN");
+    return lock.read([&]() -> decltype(auto) {
+        return std::invoke(method, xcmixin_const_self,
+                           std::forward<Args>(args)...);
+    });
+}
+// the lock guarding mixin, to lock several calls at once
+template <XCMIXIN_MIXIN_TEMPLATE_PARAM mixin>
+auto& lock_of() const {
+    return xcmixin_locks_.template get<::xcmixin::details::deref_type<
+        ::xcmixin::details::guarded_group<::xcmixin::meta_mixin<mixin>>>>();
+}
+
+private:
+mutable ::xcmixin::details::lock_table_of<Base> xcmixin_locks_;
+XCMIXIN_DEF_END()
+}  // namespace sync
+
+}  // namespace xcmixin
+#undef MIXIN
+
+// Guard a mixin by a lock of type lock, mixins declaring the same group share
+// one lock and must declare the same lock type
+#define XCMIXIN_LOCK(name, lock_type, ... /* group */)                  \
+    namespace xcmixin {                                                 \
+    template <>                                                         \
+    struct mixin_lock<::xcmixin::meta_mixin<name>> {                    \
+        static_assert(::xcmixin::details::is_valid_lock<lock_type>,     \
+                      "seq_lock only guards trivially copyable state"); \
+        using lock = lock_type;                                         \
+        using group = ::xcmixin::details::deref_type<                   \
+            ::xcmixin::details::lock_group<::xcmixin::meta_mixin<name>  \
+                __XCMIXIN_SUFIX_PARAM(__VA_ARGS__)>>;                   \
+    };                                                                  \
+    }
+
+// Define a mixin guarded by seq_lock<state>, its state lives in
+// xcmixin_seq_state: load() it to read, store() it under the write lock.
+// the mixin must not have other data members
+#define XCMIXIN_DEF_SEQ_BEGIN(mixin, ... /* state */)         \
+    template <typename Base, typename Derived, typename meta> \
+    struct mixin : Base {                                     \
+        XCMIXIN_INIT()                                        \
+        ::xcmixin::sync::seq_data<__VA_ARGS__> xcmixin_seq_state;
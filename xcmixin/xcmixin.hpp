@@ -109,6 +109,29 @@ template <typename T>
 static constexpr bool is_category = fn::contains<category_list, T>;
 }  // namespace member_category
 
+// mixin concurrency level, ordered from the strongest to the weakest guarantee
+namespace concurrency {
+// methods never write, safe to call concurrently even on the same object
+struct read_only_;
+// methods only touch their own object, safe to call concurrently on distinct
+// objects
+struct per_object_;
+// methods touch shared state, never safe to call concurrently
+struct not_parallel_;
+
+using level_list = fn::type_list<read_only_, per_object_, not_parallel_>;
+template <typename T>
+static constexpr bool is_level = fn::contains<level_list, T>;
+template <typename level>
+static constexpr int rank = invalid_value<level, int>;
+template <>
+inline constexpr int rank<read_only_> = 0;
+template <>
+inline constexpr int rank<per_object_> = 1;
+template <>
+inline constexpr int rank<not_parallel_> = 2;
+}  // namespace concurrency
+
 // template mixin validator
 template <typename Derived, typename Base, typename expected_return_type,
           typename return_type>
@@ -367,6 +390,11 @@ struct mixin_validator {
         return true;
     }
 };
+// mixin concurrency declaration, undeclared mixins are never parallel safe
+template <typename meta>
+struct mixin_concurrency {
+    using type = details::concurrency::not_parallel_;
+};
 // core framework implementation
 namespace details {
 // mixin recorder, store all mixins in it
@@ -430,6 +458,8 @@ struct impl_mixin_helper<Derived, mixin> {
     using base = mixin<EmptyBase<Derived>, Derived, meta_mixin<mixin>>;
     struct type : base {
         using xcmixin_self_class = type;
+        // the mixin layer this link of the chain adds
+        using xcmixin_layer = base;
         using mixin_recorder =
 #ifdef __GNUC__
             struct
@@ -450,6 +480,7 @@ struct impl_mixin_helper<Derived, mixin, mixins...> {
                        Derived, meta_mixin<mixin>>;
     struct type : base {
         using xcmixin_self_class = type;
+        using xcmixin_layer = base;
         using mixin_recorder = base::mixin_recorder::template push_front<mixin>;
         template <typename D = Derived>
         constexpr static bool valid_class() {
@@ -480,9 +511,39 @@ template <MIXIN mixin, MIXIN... mixins>
 static constexpr bool has_mixin<mixin, mixin_recorder<mixins...>> =
     (std::is_same_v<meta_mixin<mixin>, meta_mixin<mixins>> || ...);
 
+// position of a mixin in a recorder, the size of the recorder if absent
+template <MIXIN mixin, typename recorder>
+static constexpr size_t mixin_index = invalid_value<recorder, size_t>;
+template <MIXIN mixin>
+static constexpr size_t mixin_index<mixin, mixin_recorder<>> = 0;
+template <MIXIN mixin, MIXIN first, MIXIN... mixins>
+static constexpr size_t
+    mixin_index<mixin, mixin_recorder<first, mixins...>> =
+        std::is_same_v<meta_mixin<mixin>, meta_mixin<first>>
+            ? 0
+            : 1 + mixin_index<mixin, mixin_recorder<mixins...>>;
+
 template <typename Derived, MIXIN... mixin>
 static constexpr bool is_impl =
     (... || has_mixin<mixin, typename Derived::mixin_recorder>);
+
+// concurrency level of a mixin chain, the weakest level of all its mixins
+template <int... ranks>
+static constexpr int max_rank = 0;
+template <int r, int... ranks>
+static constexpr int max_rank<r, ranks...> =
+    r > max_rank<ranks...> ? r : max_rank<ranks...>;
+template <typename recorder>
+static constexpr int recorder_concurrency = invalid_value<recorder, int>;
+template <MIXIN... mixins>
+static constexpr int recorder_concurrency<mixin_recorder<mixins...>> =
+    max_rank<concurrency::rank<typename ::xcmixin::mixin_concurrency<
+        meta_mixin<mixins>>::type>...>;
+template <typename Derived, typename level>
+static constexpr bool is_concurrent =
+    recorder_concurrency<typename Derived::mixin_recorder> <=
+    concurrency::rank<level>;
+
 template <typename T, typename = void>
 constexpr size_t class_size = 0;
 template <typename T>
@@ -497,13 +558,17 @@ concept Impl = is_impl<T, mixin...>;
 // traits
 using details::class_size;
 using details::has_mixin;
+using details::is_concurrent;
 using details::is_impl;
+using details::mixin_index;
 // concepts
 using details::Impl;
 // overload
 using details::overload;
 using details::ret;
 using namespace details::member_category;
+// concurrency
+using namespace details::concurrency;
 // mixins
 using details::impl_mixin;
 using details::impl_recorder;
@@ -561,6 +626,19 @@ using details::recorder_concat;
     };                                                    \
     }
 
+// Declare the concurrency level of a mixin: read_only_, per_object_ or
+// not_parallel_
+#define XCMIXIN_CONCURRENCY(name, level)                         \
+    namespace xcmixin {                                          \
+    template <>                                                  \
+    struct mixin_concurrency<::xcmixin::meta_mixin<name>> {      \
+        static_assert(::xcmixin::details::concurrency::is_level< \
+                          ::xcmixin::level>,                     \
+                      #level " is not a concurrency level");     \
+        using type = ::xcmixin::level;                           \
+    };                                                           \
+    }
+
 #define XCMIXIN_PRE_DECL(mixin)                               \
     template <typename Base, typename Derived, typename meta> \
     struct mixin;